@@ -3,6 +3,9 @@
 class Ops {
 public:
     static Tensor sum(const Tensor& tensor, int dim) {
+        if (tensor.getLayout() != Layout::RowMajor) {
+            return sum(tensor.contiguous(), dim);
+        }
         const vector<int>& shape = tensor.getShape();
 
         if (dim == -1) {
@@ -44,6 +47,41 @@ public:
         return result;
     }
 
+    // Affine coupling on a [B, C, T] tensor. The first C / 2 channels are the
+    // identity half and are left untouched; the rest become x * exp(log_scale) + shift
+    // in place. `log_scale` and `shift` have shape [B, C - C / 2, T].
+    static void affineCouplingInPlace(Tensor& x, const Tensor& log_scale, const Tensor& shift) {
+        vector<int> shape = x.getShape();
+        if (shape.size() != 3) {
+            std::cerr << "Affine coupling expects a [B, C, T] tensor" << std::endl;
+            return;
+        }
+
+        if (x.getLayout() != Layout::RowMajor) {
+            x = x.contiguous();
+        }
+
+        int half = shape[1] / 2;
+        TensorView transformed = x.narrow(1, half, shape[1] - half);
+        if (log_scale.getShape() != transformed.getShape() || shift.getShape() != transformed.getShape()) {
+            std::cerr << "Shape mismatch for affine coupling" << std::endl;
+            return;
+        }
+
+        if (log_scale.getLayout() != Layout::RowMajor || shift.getLayout() != Layout::RowMajor) {
+            affineCouplingInPlace(x, log_scale.contiguous(), shift.contiguous());
+            return;
+        }
+
+        transformed.forEachRun([&](float* run, int offset, int length) {
+            const float* s = log_scale.data().data() + offset;
+            const float* t = shift.data().data() + offset;
+            for (int i = 0; i < length; ++i) {
+                run[i] = run[i] * std::exp(s[i]) + t[i];
+            }
+        });
+    }
+
     static Tensor searchSorted(const Tensor bin_locations, const Tensor inputs, float eps=0.000001) {
         return Tensor();
     }
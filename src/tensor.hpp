@@ -9,10 +9,63 @@
 #include <cstdlib>
 #include <ctime>
 #include <random>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+#include "transpose.hpp"
+#include "tensor_parser.hpp"
 
 using std::vector;
 using std::string;
 
+// How the logical axes map onto data_. ChannelsLast keeps the last two logical
+// axes swapped in memory: a [B, C, T, K] tensor is stored as [B, C, K, T].
+enum class Layout {
+    RowMajor,
+    ChannelsLast
+};
+
+class Tensor;
+
+// Non-owning window onto a range of one axis of a row-major tensor, e.g. half the
+// channels of a [B, C, T] tensor. It is a set of equally spaced contiguous runs,
+// so producers can write straight into the destination instead of into a
+// temporary that is concatenated later. Only valid while the tensor it came from
+// is neither resized nor reassigned.
+class TensorView {
+public:
+    TensorView(float* base, const vector<int>& shape, int num_runs, int run_length, int run_stride)
+        : base_(base), shape_(shape), num_runs_(num_runs), run_length_(run_length), run_stride_(run_stride) {}
+
+    vector<int> getShape() const {
+        return shape_;
+    }
+
+    int size() const {
+        return num_runs_ * run_length_;
+    }
+
+    // Calls `fn(run, offset, length)` for each contiguous run, where `offset` is
+    // the row-major index of run[0] within the view.
+    template <typename Fn>
+    void forEachRun(Fn fn) const {
+        for (int r = 0; r < num_runs_; ++r) {
+            fn(base_ + r * run_stride_, r * run_length_, run_length_);
+        }
+    }
+
+    void assign(const Tensor& src);
+    Tensor materialize() const;
+
+private:
+    float* base_;
+    vector<int> shape_;
+    int num_runs_;
+    int run_length_;
+    int run_stride_;
+};
+
 class Tensor {
 public:
     Tensor() {}
@@ -33,6 +86,12 @@ public:
         }
     }
     ~Tensor() {}
+    // The user-declared destructor would otherwise suppress the implicit moves and
+    // turn every returned Tensor into a full copy.
+    Tensor(const Tensor&) = default;
+    Tensor(Tensor&&) = default;
+    Tensor& operator=(const Tensor&) = default;
+    Tensor& operator=(Tensor&&) = default;
 
     void load(const string& file) {
         std::ifstream infile(file);
@@ -54,12 +113,178 @@ public:
             }
         }
         infile.close();
+        layout_ = Layout::RowMajor;
+    }
+
+    // Same format as load(), read in large blocks and parsed on `num_threads` threads
+    // (0 picks the hardware concurrency) directly into data_.
+    bool loadParallel(const string& file, int num_threads = 0) {
+        string text;
+        if (!TensorParser::readFile(file, text)) {
+            return false;
+        }
+        if (!TensorParser::parse(text, data_.data(), data_.size(), num_threads)) {
+            return false;
+        }
+        layout_ = Layout::RowMajor;
+        return true;
     }
 
     void reshape(const vector<int>& new_shape) {
+        if (layout_ != Layout::RowMajor) {
+            *this = contiguous();
+        }
         shape_ = new_shape;
     }
 
+    Tensor permute(const vector<int>& dims) const {
+        int ndim = shape_.size();
+        if ((int)dims.size() != ndim) {
+            std::cerr << "Permutation does not match the number of dimensions" << std::endl;
+            return Tensor();
+        }
+
+        vector<int> axes(ndim);
+        vector<bool> seen(ndim, false);
+        for (int i = 0; i < ndim; ++i) {
+            int dim = dims[i] < 0 ? dims[i] + ndim : dims[i];
+            if (dim < 0 || dim >= ndim || seen[dim]) {
+                std::cerr << "Invalid permutation" << std::endl;
+                return Tensor();
+            }
+            seen[dim] = true;
+            axes[i] = dim;
+        }
+
+        vector<int> strides = getStrides();
+        vector<int> new_shape(ndim);
+        vector<int> new_strides(ndim);
+        for (int i = 0; i < ndim; ++i) {
+            new_shape[i] = shape_[axes[i]];
+            new_strides[i] = strides[axes[i]];
+        }
+
+        // Zero-size inputs, including a default-constructed Tensor, have no data to move.
+        if (data_.empty()) {
+            Tensor result;
+            result.shape_ = new_shape;
+            return result;
+        }
+
+        Tensor result(new_shape);
+        Transpose::permute(data_.data(), new_shape, new_strides, result.data_.data());
+        return result;
+    }
+
+    // Swaps the last two axes without moving any data by flipping the layout tag.
+    void transposeLastView() {
+        if (shape_.size() < 2) {
+            std::cerr << "transposeLastView needs at least two dimensions" << std::endl;
+            return;
+        }
+        std::swap(shape_[shape_.size() - 1], shape_[shape_.size() - 2]);
+        layout_ = (layout_ == Layout::RowMajor) ? Layout::ChannelsLast : Layout::RowMajor;
+    }
+
+    // View of [start, start + length) along `dim`; nothing is copied. Only row-major
+    // tensors can be narrowed, so call contiguous() first on a ChannelsLast tensor.
+    TensorView narrow(int dim, int start, int length) {
+        if (layout_ != Layout::RowMajor) {
+            std::cerr << "narrow needs a row-major tensor" << std::endl;
+            return TensorView(data_.data(), {0}, 0, 0, 0);
+        }
+        if (dim < 0) {
+            dim += shape_.size();
+        }
+        if (dim < 0 || dim >= (int)shape_.size() || start < 0 || length < 0 || start + length > shape_[dim]) {
+            std::cerr << "Invalid narrow range" << std::endl;
+            return TensorView(data_.data(), {0}, 0, 0, 0);
+        }
+
+        int outer = 1;
+        for (int i = 0; i < dim; ++i) {
+            outer *= shape_[i];
+        }
+        int inner = 1;
+        for (size_t i = dim + 1; i < shape_.size(); ++i) {
+            inner *= shape_[i];
+        }
+
+        vector<int> view_shape = shape_;
+        view_shape[dim] = length;
+        return TensorView(data_.data() + start * inner, view_shape, outer, length * inner, shape_[dim] * inner);
+    }
+
+    // Consecutive views along `dim` with the given sizes, which must add up to the
+    // size of that axis.
+    vector<TensorView> split(int dim, const vector<int>& sizes) {
+        if (dim < 0) {
+            dim += shape_.size();
+        }
+        if (dim < 0 || dim >= (int)shape_.size() || std::accumulate(sizes.begin(), sizes.end(), 0) != shape_[dim]) {
+            std::cerr << "Split sizes do not match the dimension" << std::endl;
+            return {};
+        }
+        if (std::any_of(sizes.begin(), sizes.end(), [](int size) { return size < 0; })) {
+            std::cerr << "Split sizes must not be negative" << std::endl;
+            return {};
+        }
+
+        vector<TensorView> views;
+        int start = 0;
+        for (int size : sizes) {
+            views.push_back(narrow(dim, start, size));
+            start += size;
+        }
+        return views;
+    }
+
+    // Inputs are passed by pointer so each one is copied exactly once, straight
+    // into its slice of the result.
+    static Tensor concat(const vector<const Tensor*>& tensors, int dim) {
+        if (tensors.empty()) {
+            std::cerr << "Nothing to concatenate" << std::endl;
+            return Tensor();
+        }
+
+        const vector<int>& first_shape = tensors[0]->shape_;
+        vector<int> new_shape = first_shape;
+        if (dim < 0) {
+            dim += new_shape.size();
+        }
+        if (dim < 0 || dim >= (int)new_shape.size()) {
+            std::cerr << "Invalid dimension" << std::endl;
+            return Tensor();
+        }
+
+        new_shape[dim] = 0;
+        vector<int> sizes;
+        for (const Tensor* tensor : tensors) {
+            if (tensor->shape_.size() != new_shape.size() || !sameExceptDim(tensor->shape_, first_shape, dim)) {
+                std::cerr << "Shape mismatch for concat" << std::endl;
+                return Tensor();
+            }
+            sizes.push_back(tensor->shape_[dim]);
+            new_shape[dim] += tensor->shape_[dim];
+        }
+
+        Tensor result(new_shape);
+        vector<TensorView> views = result.split(dim, sizes);
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            views[i].assign(*tensors[i]);
+        }
+        return result;
+    }
+
+    Tensor contiguous() const {
+        if (layout_ == Layout::RowMajor) {
+            return *this;
+        }
+        vector<int> dims(shape_.size());
+        std::iota(dims.begin(), dims.end(), 0);
+        return permute(dims);
+    }
+
     float min() const {
         float min = data_[0];
         for (float value : data_) {
@@ -81,6 +306,9 @@ public:
     }
 
     Tensor sliceLast(int index) {
+        if (layout_ != Layout::RowMajor) {
+            return contiguous().sliceLast(index);
+        }
         if (index == -1) {
             index = shape_.back() - 1;
         }
@@ -107,6 +335,9 @@ public:
     }
 
     Tensor sliceLast(std::optional<int> start_opt = std::nullopt, std::optional<int> end_opt = std::nullopt) {
+        if (layout_ != Layout::RowMajor) {
+            return contiguous().sliceLast(start_opt, end_opt);
+        }
         int start = start_opt.value_or(0);
         int end = end_opt.value_or(shape_.back());
 
@@ -143,6 +374,9 @@ public:
     }
 
     Tensor cumsum() {
+        if (layout_ == Layout::ChannelsLast) {
+            return cumsumChannelsLast();
+        }
         int last_dim_size = shape_.back();
         int num_slices = data_.size() / last_dim_size;
 
@@ -161,6 +395,9 @@ public:
     }
 
     Tensor softmax_last_dim() const {
+        if (layout_ == Layout::ChannelsLast) {
+            return softmaxChannelsLast();
+        }
         Tensor result(shape_);
 
         int last_dim_size = shape_.back();
@@ -181,6 +418,9 @@ public:
     }
 
     Tensor pad(bool pad_left, bool pad_right) const {
+        if (layout_ != Layout::RowMajor) {
+            return contiguous().pad(pad_left, pad_right);
+        }
         int dims = shape_.size();
         if (dims < 2 || dims > 4) {
             std::cerr << "The function supports tensors from 2D to 4D." << std::endl;
@@ -213,6 +453,12 @@ public:
     }
     
     Tensor gather(const Tensor& bin_idx) const {
+        if (layout_ != Layout::RowMajor) {
+            return contiguous().gather(bin_idx);
+        }
+        if (bin_idx.layout_ != Layout::RowMajor) {
+            return gather(bin_idx.contiguous());
+        }
         if (shape_.size() != bin_idx.shape_.size()) {
             std::cerr << "Shape mismatch!" << std::endl;
             return Tensor();
@@ -250,6 +496,8 @@ public:
         return result;
     }
     
+    // getData() and data() expose storage in memory order, which for ChannelsLast
+    // tensors is not the logical order; call contiguous() first to read it logically.
     vector<float> getData() const {
         return data_;
     }
@@ -258,17 +506,46 @@ public:
         return data_;
     }
 
+    const vector<float>& data() const {
+        return data_;
+    }
+
     vector<int> getShape() const {
         return shape_;
     }
 
+    Layout getLayout() const {
+        return layout_;
+    }
+
+    // Element stride in data_ of each logical axis.
+    vector<int> getStrides() const {
+        int ndim = shape_.size();
+        vector<int> memory_shape = shape_;
+        if (layout_ == Layout::ChannelsLast) {
+            std::swap(memory_shape[ndim - 1], memory_shape[ndim - 2]);
+        }
+
+        vector<int> strides(ndim, 1);
+        for (int i = ndim - 2; i >= 0; --i) {
+            strides[i] = strides[i + 1] * memory_shape[i + 1];
+        }
+        if (layout_ == Layout::ChannelsLast) {
+            std::swap(strides[ndim - 1], strides[ndim - 2]);
+        }
+        return strides;
+    }
+
     Tensor operator+(const Tensor &other) const {
         if (shape_ != other.getShape()) {
             std::cerr << "Shape mismatch for tensor addition" << std::endl;
             return Tensor();
         }
+        if (layout_ != other.layout_) {
+            return (layout_ == Layout::RowMajor) ? *this + other.contiguous() : contiguous() + other;
+        }
 
-        Tensor result(shape_);
+        Tensor result = emptyLike();
         for (size_t i = 0; i < data_.size(); ++i) {
             result.data()[i] = data_[i] + other.getData()[i];
         }
@@ -277,7 +554,7 @@ public:
     }
 
     Tensor operator+(float scalar) const {
-        Tensor result(shape_);
+        Tensor result = emptyLike();
         for (size_t i = 0; i < data_.size(); ++i) {
             result.data()[i] = data_[i] + scalar;
         }
@@ -290,8 +567,11 @@ public:
             std::cerr << "Shape mismatch for tensor addition" << std::endl;
             return Tensor();
         }
+        if (layout_ != other.layout_) {
+            return (layout_ == Layout::RowMajor) ? *this * other.contiguous() : contiguous() * other;
+        }
 
-        Tensor result(shape_);
+        Tensor result = emptyLike();
         for (size_t i = 0; i < data_.size(); ++i) {
             result.data()[i] = data_[i] * other.getData()[i];
         }
@@ -300,7 +580,7 @@ public:
     }
 
     Tensor operator*(float scalar) const {
-        Tensor result(shape_);
+        Tensor result = emptyLike();
         for (size_t i = 0; i < data_.size(); ++i) {
             result.data()[i] = data_[i] * scalar;
         }
@@ -309,6 +589,12 @@ public:
     }
 
     Tensor operator>=(const Tensor &other) const {
+        if (layout_ != Layout::RowMajor) {
+            return contiguous() >= other;
+        }
+        if (other.layout_ != Layout::RowMajor) {
+            return *this >= other.contiguous();
+        }
         if (shape_ == other.getShape()) {
             Tensor result(shape_);
             for (size_t i = 0; i < data_.size(); ++i) {
@@ -332,7 +618,7 @@ public:
     }
 
     Tensor operator>=(float scalar) const {
-        Tensor result(shape_);
+        Tensor result = emptyLike();
         for (size_t i = 0; i < data_.size(); ++i) {
             result.data()[i] = (data_[i] >= scalar) ? 1.0f : 0.0f;
         }
@@ -342,10 +628,83 @@ public:
     friend Tensor operator>=(float scalar, const Tensor &tensor);
     friend Tensor operator+(float scalar, const Tensor &tensor);
     friend Tensor operator*(float scalar, const Tensor &tensor);
+    friend class TensorView;
 
 private:
     vector<float> data_;
     vector<int> shape_;
+    Layout layout_ = Layout::RowMajor;
+
+    static bool sameExceptDim(const vector<int>& a, const vector<int>& b, int dim) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            if ((int)i != dim && a[i] != b[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Tensor emptyLike() const {
+        Tensor result(shape_);
+        result.layout_ = layout_;
+        return result;
+    }
+
+    // Logical [..., T, K] stored as [..., K, T]: walk K in the outer loop and keep
+    // the contiguous T axis innermost rather than transposing first.
+    Tensor softmaxChannelsLast() const {
+        Tensor result = emptyLike();
+
+        int k_size = shape_.back();
+        int t_size = shape_[shape_.size() - 2];
+        int plane = k_size * t_size;
+        int num_planes = data_.size() / plane;
+        vector<float> sum_exp(t_size);
+
+        for (int p = 0; p < num_planes; ++p) {
+            const float* in = data_.data() + p * plane;
+            float* out = result.data_.data() + p * plane;
+            std::fill(sum_exp.begin(), sum_exp.end(), 0.0f);
+
+            for (int k = 0; k < k_size; ++k) {
+                for (int t = 0; t < t_size; ++t) {
+                    float e = std::exp(in[k * t_size + t]);
+                    out[k * t_size + t] = e;
+                    sum_exp[t] += e;
+                }
+            }
+            for (int k = 0; k < k_size; ++k) {
+                for (int t = 0; t < t_size; ++t) {
+                    out[k * t_size + t] /= sum_exp[t];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    Tensor cumsumChannelsLast() const {
+        Tensor result = emptyLike();
+
+        int k_size = shape_.back();
+        int t_size = shape_[shape_.size() - 2];
+        int plane = k_size * t_size;
+        int num_planes = data_.size() / plane;
+
+        for (int p = 0; p < num_planes; ++p) {
+            const float* in = data_.data() + p * plane;
+            float* out = result.data_.data() + p * plane;
+
+            std::copy(in, in + t_size, out);
+            for (int k = 1; k < k_size; ++k) {
+                for (int t = 0; t < t_size; ++t) {
+                    out[k * t_size + t] = out[(k - 1) * t_size + t] + in[k * t_size + t];
+                }
+            }
+        }
+
+        return result;
+    }
 };
 
 inline Tensor operator+(float scalar, const Tensor &tensor) {
@@ -357,10 +716,33 @@ inline Tensor operator*(float scalar, const Tensor &tensor) {
 }
 
 inline Tensor operator>=(float scalar, const Tensor &tensor) {
-    Tensor result(tensor.getShape());
+    Tensor result = tensor.emptyLike();
     const vector<float>& tensorData = tensor.getData();
     for (size_t i = 0; i < tensorData.size(); ++i) {
         result.data()[i] = (scalar >= tensorData[i]) ? 1.0f : 0.0f;
     }
     return result;
-}
\ No newline at end of file
+}
+inline void TensorView::assign(const Tensor& src) {
+    if (src.getShape() != shape_) {
+        std::cerr << "Shape mismatch for view assignment" << std::endl;
+        return;
+    }
+    if (src.layout_ != Layout::RowMajor) {
+        assign(src.contiguous());
+        return;
+    }
+    const float* data = src.data_.data();
+    forEachRun([&](float* run, int offset, int length) {
+        std::copy(data + offset, data + offset + length, run);
+    });
+}
+
+inline Tensor TensorView::materialize() const {
+    Tensor result(shape_);
+    float* data = result.data().data();
+    forEachRun([&](float* run, int offset, int length) {
+        std::copy(run, run + length, data + offset);
+    });
+    return result;
+}
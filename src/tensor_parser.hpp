@@ -0,0 +1,142 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <charconv>
+#include <algorithm>
+#include <iterator>
+
+using std::vector;
+using std::string;
+
+// Parser for the comma-separated text written by tests/generate_tensor_files.py.
+class TensorParser {
+public:
+    static bool readFile(const string& file, string& buffer) {
+        std::ifstream infile(file, std::ios::binary);
+        if (!infile.is_open()) {
+            std::cerr << "Cannot open file: " << file << std::endl;
+            return false;
+        }
+
+        infile.seekg(0, std::ios::end);
+        std::streamoff size = infile.tellg();
+        if (size < 0) {
+            std::cerr << "Cannot determine size of file: " << file << std::endl;
+            return false;
+        }
+        infile.seekg(0, std::ios::beg);
+
+        buffer.resize(size);
+        if (!infile.read(buffer.data(), size)) {
+            std::cerr << "Failed to read file: " << file << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Parses `text` into `out`, which must hold exactly `expected` values. The text
+    // is cut after commas into one chunk per thread; each thread counts its values,
+    // then parses them straight into its slice of `out`.
+    static bool parse(const string& text, float* out, size_t expected, int num_threads = 0) {
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+
+        if (num_threads <= 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        num_threads = std::max<size_t>(1, std::min<size_t>(num_threads, text.size() / kMinChunk));
+
+        vector<const char*> bounds(num_threads + 1, end);
+        bounds[0] = begin;
+        for (int i = 1; i < num_threads; ++i) {
+            const char* p = std::max(begin + text.size() * i / num_threads, bounds[i - 1]);
+            p = std::find(p, end, ',');
+            bounds[i] = (p == end) ? end : p + 1;
+        }
+
+        vector<size_t> counts(num_threads, 0);
+        runChunks(num_threads, [&](int i) {
+            counts[i] = countValues(bounds[i], bounds[i + 1], bounds[i + 1] == end);
+        });
+
+        vector<size_t> offsets(num_threads, 0);
+        for (int i = 1; i < num_threads; ++i) {
+            offsets[i] = offsets[i - 1] + counts[i - 1];
+        }
+        size_t total = offsets.back() + counts.back();
+        if (total != expected) {
+            std::cerr << "Element count mismatch: file has " << total << " values, tensor expects " << expected << std::endl;
+            return false;
+        }
+
+        vector<char> ok(num_threads, 0);
+        runChunks(num_threads, [&](int i) {
+            ok[i] = parseValues(bounds[i], bounds[i + 1], out + offsets[i], counts[i]);
+        });
+        if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+            std::cerr << "Invalid value in tensor file" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static constexpr size_t kMinChunk = 1 << 20;
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    template <typename Fn>
+    static void runChunks(int num_threads, Fn fn) {
+        vector<std::thread> workers;
+        for (int i = 1; i < num_threads; ++i) {
+            workers.emplace_back(fn, i);
+        }
+        fn(0);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // Every value but the very last is followed by a comma, so the commas give the
+    // count; a chunk that reaches the end of the text adds one more if anything
+    // follows its final comma. Chunks after it are empty and count nothing.
+    static size_t countValues(const char* begin, const char* end, bool last) {
+        size_t count = std::count(begin, end, ',');
+        if (last) {
+            const char* tail = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(begin), ',').base();
+            if (std::find_if_not(tail, end, isSpace) != end) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    static bool parseValues(const char* p, const char* end, float* out, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            while (p != end && isSpace(*p)) {
+                ++p;
+            }
+            auto [next, ec] = std::from_chars(p, end, out[i]);
+            if (ec != std::errc()) {
+                return false;
+            }
+            p = next;
+            while (p != end && isSpace(*p)) {
+                ++p;
+            }
+            if (p != end) {
+                if (*p != ',') {
+                    return false;
+                }
+                ++p;
+            }
+        }
+        return true;
+    }
+};
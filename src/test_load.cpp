@@ -0,0 +1,91 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include "tensor.hpp"
+#include "test_utils.hpp"
+
+// Writes `values` the way tests/generate_tensor_files.py does: ", " separated, one line.
+void writeTensorFile(const std::string& path, const vector<float>& values) {
+    std::ofstream out(path);
+    char buffer[32];
+    for (size_t i = 0; i < values.size(); ++i) {
+        std::snprintf(buffer, sizeof(buffer), "%.9g", values[i]);
+        out << (i ? ", " : "") << buffer;
+    }
+}
+
+void test_loadParallel_matches_load() {
+    Tensor source({1, 1, 55, 10}, true);
+    writeTensorFile("test_load_small.txt", source.getData());
+
+    Tensor expected({1, 1, 55, 10});
+    expected.load("test_load_small.txt");
+    Tensor result({1, 1, 55, 10});
+    bool ok = result.loadParallel("test_load_small.txt");
+
+    check(ok && result.getData() == expected.getData() && result.getData() == source.getData(), "test_loadParallel_matches_load");
+    std::remove("test_load_small.txt");
+}
+
+void test_loadParallel_many_threads() {
+    // Large enough that the text is split into several chunks.
+    Tensor source({4, 250000}, true);
+    writeTensorFile("test_load_large.txt", source.getData());
+
+    Tensor result({4, 250000});
+    bool ok = result.loadParallel("test_load_large.txt", 8);
+
+    check(ok && result.getData() == source.getData(), "test_loadParallel_many_threads");
+    std::remove("test_load_large.txt");
+}
+
+void test_loadParallel_comma_free_tail() {
+    // No comma after the split points, so every chunk but the first is empty.
+    {
+        std::ofstream out("test_load_tail.txt");
+        out << "1.5, 2.5" << std::string(3 << 20, ' ');
+    }
+
+    Tensor result({2});
+    bool ok = result.loadParallel("test_load_tail.txt", 3);
+
+    check(ok && result.getData() == vector<float>({1.5f, 2.5f}), "test_loadParallel_comma_free_tail");
+    std::remove("test_load_tail.txt");
+}
+
+void test_loadParallel_count_mismatch() {
+    Tensor source({3, 5}, true);
+    writeTensorFile("test_load_mismatch.txt", source.getData());
+
+    Tensor result({4, 5});
+    check(!result.loadParallel("test_load_mismatch.txt"), "test_loadParallel_count_mismatch");
+    std::remove("test_load_mismatch.txt");
+}
+
+void test_loadParallel_invalid_value() {
+    std::ofstream("test_load_invalid.txt") << "1.5, abc, 2.0\n";
+
+    Tensor result({3});
+    check(!result.loadParallel("test_load_invalid.txt"), "test_loadParallel_invalid_value");
+    std::remove("test_load_invalid.txt");
+}
+
+void test_loadParallel_missing_file() {
+    Tensor result({3});
+    check(!result.loadParallel("test_load_does_not_exist.txt"), "test_loadParallel_missing_file");
+}
+
+int main() {
+    test_loadParallel_matches_load();
+    test_loadParallel_many_threads();
+    test_loadParallel_comma_free_tail();
+    test_loadParallel_count_mismatch();
+    test_loadParallel_invalid_value();
+    test_loadParallel_missing_file();
+
+    std::cout << "Tests completed" << std::endl;
+    std::cout << "Passed: " << tests_passed << ", Failed: " << tests_failed << std::endl;
+    return 0;
+}
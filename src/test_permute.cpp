@@ -0,0 +1,153 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include "tensor.hpp"
+#include "test_utils.hpp"
+
+bool allClose(const vector<float>& a, const vector<float>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::fabs(a[i] - b[i]) > 1e-5f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_permute_2d_transpose() {
+    // Odd sizes so both the 8x8 kernel and the edge loops run.
+    int rows = 77, cols = 141;
+    Tensor tensor({rows, cols}, true);
+    Tensor result = tensor.permute({1, 0});
+
+    vector<float> expected(rows * cols);
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            expected[j * rows + i] = tensor.getData()[i * cols + j];
+        }
+    }
+    check(result.getShape() == vector<int>({cols, rows}) && allClose(result.getData(), expected), "test_permute_2d_transpose");
+}
+
+void test_permute_channels_to_time() {
+    int b = 2, c = 19, t = 37;
+    Tensor tensor({b, c, t}, true);
+    Tensor result = tensor.permute({0, 2, 1});
+
+    vector<float> expected(b * c * t);
+    for (int bi = 0; bi < b; ++bi) {
+        for (int ci = 0; ci < c; ++ci) {
+            for (int ti = 0; ti < t; ++ti) {
+                expected[(bi * t + ti) * c + ci] = tensor.getData()[(bi * c + ci) * t + ti];
+            }
+        }
+    }
+    check(result.getShape() == vector<int>({b, t, c}) && allClose(result.getData(), expected), "test_permute_channels_to_time");
+}
+
+void test_permute_4d() {
+    vector<int> shape = {3, 5, 9, 11};
+    Tensor tensor(shape, true);
+    Tensor result = tensor.permute({2, 0, 3, 1});
+
+    vector<float> expected(tensor.getData().size());
+    int idx = 0;
+    for (int i2 = 0; i2 < shape[2]; ++i2) {
+        for (int i0 = 0; i0 < shape[0]; ++i0) {
+            for (int i3 = 0; i3 < shape[3]; ++i3) {
+                for (int i1 = 0; i1 < shape[1]; ++i1) {
+                    expected[idx++] = tensor.getData()[((i0 * shape[1] + i1) * shape[2] + i2) * shape[3] + i3];
+                }
+            }
+        }
+    }
+    check(result.getShape() == vector<int>({9, 3, 11, 5}) && allClose(result.getData(), expected), "test_permute_4d");
+}
+
+void test_permute_identity() {
+    Tensor tensor({4, 6, 8}, true);
+    Tensor result = tensor.permute({0, 1, -1});
+    check(allClose(result.getData(), tensor.getData()), "test_permute_identity");
+}
+
+void test_permute_empty_tensor() {
+    check(Tensor().permute({}).getShape().empty(), "test_permute_empty_tensor");
+}
+
+void test_permute_zero_size() {
+    Tensor tensor({0, 5});
+    check(tensor.permute({1, 0}).getShape() == vector<int>({5, 0}), "test_permute_zero_size_shape");
+    check(tensor.permute({0, 0}).getShape().empty(), "test_permute_zero_size_invalid_dims");
+}
+
+void test_block8x8_kernels() {
+    // Leading dimensions wider than the tile, as inside a tiled transpose.
+    int src_ld = 11, dst_ld = 13;
+    Tensor src({8, src_ld}, true);
+    vector<float> expected(8 * dst_ld, 0.0f);
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            expected[i * dst_ld + j] = src.getData()[j * src_ld + i];
+        }
+    }
+
+    vector<float> dst(8 * dst_ld, 0.0f);
+    Transpose::block8x8Sse(src.data().data(), src_ld, dst.data(), dst_ld);
+    check(dst == expected, "test_block8x8_sse");
+
+#if defined(TRANSPOSE_AVX_DISPATCH)
+    if (Transpose::hasAvx()) {
+        std::fill(dst.begin(), dst.end(), 0.0f);
+        Transpose::block8x8Avx(src.data().data(), src_ld, dst.data(), dst_ld);
+        check(dst == expected, "test_block8x8_avx");
+    }
+#endif
+}
+
+void test_mixed_layout_comparison() {
+    Tensor a({3, 4, 5}, true);
+    Tensor b({3, 5, 4}, true);
+    b.transposeLastView();
+    check((a >= b).getData() == (a >= b.contiguous()).getData(), "test_mixed_layout_comparison");
+}
+
+void test_transpose_last_view_contiguous() {
+    Tensor tensor({2, 10, 13}, true);
+    Tensor view = tensor;
+    view.transposeLastView();
+    Tensor expected = tensor.permute({0, 2, 1});
+
+    check(view.getLayout() == Layout::ChannelsLast && view.getShape() == vector<int>({2, 13, 10}), "test_transpose_last_view_shape");
+    check(allClose(view.contiguous().getData(), expected.getData()), "test_transpose_last_view_contiguous");
+}
+
+void test_channels_last_softmax_cumsum() {
+    // [B, C, K, T] conditioner output viewed as the [B, C, T, K] per-bin layout.
+    Tensor tensor({1, 2, 10, 55}, true);
+    Tensor view = tensor;
+    view.transposeLastView();
+    Tensor expected = tensor.permute({0, 1, 3, 2});
+
+    check(allClose(view.softmax_last_dim().contiguous().getData(), expected.softmax_last_dim().getData()), "test_channels_last_softmax");
+    check(allClose(view.cumsum().contiguous().getData(), expected.cumsum().getData()), "test_channels_last_cumsum");
+}
+
+int main() {
+    test_permute_2d_transpose();
+    test_permute_channels_to_time();
+    test_permute_4d();
+    test_permute_identity();
+    test_permute_empty_tensor();
+    test_permute_zero_size();
+    test_block8x8_kernels();
+    test_mixed_layout_comparison();
+    test_transpose_last_view_contiguous();
+    test_channels_last_softmax_cumsum();
+
+    std::cout << "Tests completed" << std::endl;
+    std::cout << "Passed: " << tests_passed << ", Failed: " << tests_failed << std::endl;
+    return 0;
+}
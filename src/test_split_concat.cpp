@@ -0,0 +1,147 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include "tensor.hpp"
+#include "ops.hpp"
+#include "test_utils.hpp"
+
+void test_concat_channels() {
+    Tensor a({2, 3, 5}, true);
+    Tensor b({2, 4, 5}, true);
+    Tensor result = Tensor::concat({&a, &b}, 1);
+
+    bool ok = result.getShape() == vector<int>({2, 7, 5});
+    for (int bi = 0; bi < 2 && ok; ++bi) {
+        for (int c = 0; c < 7; ++c) {
+            for (int t = 0; t < 5; ++t) {
+                float expected = c < 3 ? a.getData()[(bi * 3 + c) * 5 + t] : b.getData()[(bi * 4 + c - 3) * 5 + t];
+                ok = ok && result.getData()[(bi * 7 + c) * 5 + t] == expected;
+            }
+        }
+    }
+    check(ok, "test_concat_channels");
+}
+
+void test_concat_last_dim() {
+    Tensor a({3, 2}, true);
+    Tensor b({3, 1}, true);
+    Tensor result = Tensor::concat({&a, &b}, -1);
+
+    bool ok = result.getShape() == vector<int>({3, 3});
+    for (int i = 0; i < 3 && ok; ++i) {
+        ok = result.getData()[i * 3] == a.getData()[i * 2]
+            && result.getData()[i * 3 + 1] == a.getData()[i * 2 + 1]
+            && result.getData()[i * 3 + 2] == b.getData()[i];
+    }
+    check(ok, "test_concat_last_dim");
+}
+
+void test_concat_shape_mismatch() {
+    Tensor a({2, 3, 5});
+    Tensor b({2, 3, 4});
+    check(Tensor::concat({&a, &b}, 1).getShape().empty(), "test_concat_shape_mismatch");
+}
+
+void test_concat_computed_input() {
+    // Results of other ops are passed as named tensors.
+    Tensor a({2, 3}, true);
+    Tensor doubled = a * 2.0f;
+    Tensor result = Tensor::concat({&a, &doubled}, 0);
+
+    check(result.getShape() == vector<int>({4, 3}) && result.getData()[6] == 2.0f * a.getData()[0], "test_concat_computed_input");
+}
+
+void test_narrow_writes_into_tensor() {
+    Tensor tensor({2, 4, 3});
+    TensorView view = tensor.narrow(1, 1, 2);
+    const float* begin = tensor.data().data();
+    const float* end = begin + tensor.data().size();
+
+    bool aliases = true;
+    view.forEachRun([&](float* run, int offset, int length) {
+        aliases = aliases && run >= begin && run + length <= end;
+        for (int i = 0; i < length; ++i) {
+            run[i] = 1.0f;
+        }
+    });
+
+    // Channel 1 and 2 of each batch now hold ones; channels 0 and 3 are untouched.
+    bool ok = aliases;
+    for (int bi = 0; bi < 2; ++bi) {
+        for (int c = 0; c < 4; ++c) {
+            for (int t = 0; t < 3; ++t) {
+                float expected = (c == 1 || c == 2) ? 1.0f : 0.0f;
+                ok = ok && tensor.getData()[(bi * 4 + c) * 3 + t] == expected;
+            }
+        }
+    }
+    check(ok, "test_narrow_writes_into_tensor");
+}
+
+void test_narrow_rejects_channels_last() {
+    Tensor tensor({2, 4, 3});
+    tensor.transposeLastView();
+    TensorView view = tensor.narrow(1, 0, 2);
+    check(view.size() == 0 && tensor.getLayout() == Layout::ChannelsLast, "test_narrow_rejects_channels_last");
+}
+
+void test_split_negative_size() {
+    Tensor tensor({2, 4, 3});
+    check(tensor.split(1, {5, -1}).empty(), "test_split_negative_size");
+}
+
+void test_split_views_write_into_destination() {
+    Tensor a({2, 3, 5}, true);
+    Tensor b({2, 4, 5}, true);
+    Tensor destination({2, 7, 5});
+    vector<TensorView> views = destination.split(1, {3, 4});
+    views[0].assign(a);
+    views[1].assign(b);
+
+    check(destination.getData() == Tensor::concat({&a, &b}, 1).getData(), "test_split_views_write_into_destination");
+    check(views[1].materialize().getData() == b.getData(), "test_split_views_materialize");
+}
+
+void test_affine_coupling_in_place() {
+    Tensor x({2, 6, 4}, true);
+    Tensor log_scale({2, 3, 4}, true);
+    Tensor shift({2, 3, 4}, true);
+    Tensor original = x;
+    Ops::affineCouplingInPlace(x, log_scale, shift);
+
+    bool identity_ok = true;
+    bool transformed_ok = true;
+    for (int bi = 0; bi < 2; ++bi) {
+        for (int c = 0; c < 6; ++c) {
+            for (int t = 0; t < 4; ++t) {
+                int idx = (bi * 6 + c) * 4 + t;
+                if (c < 3) {
+                    identity_ok = identity_ok && x.getData()[idx] == original.getData()[idx];
+                } else {
+                    int p = (bi * 3 + c - 3) * 4 + t;
+                    float expected = original.getData()[idx] * std::exp(log_scale.getData()[p]) + shift.getData()[p];
+                    transformed_ok = transformed_ok && std::fabs(x.getData()[idx] - expected) < 1e-5f;
+                }
+            }
+        }
+    }
+    check(identity_ok, "test_affine_coupling_identity_half");
+    check(transformed_ok, "test_affine_coupling_transformed_half");
+}
+
+int main() {
+    test_concat_channels();
+    test_concat_last_dim();
+    test_concat_shape_mismatch();
+    test_concat_computed_input();
+    test_narrow_writes_into_tensor();
+    test_narrow_rejects_channels_last();
+    test_split_negative_size();
+    test_split_views_write_into_destination();
+    test_affine_coupling_in_place();
+
+    std::cout << "Tests completed" << std::endl;
+    std::cout << "Passed: " << tests_passed << ", Failed: " << tests_failed << std::endl;
+    return 0;
+}
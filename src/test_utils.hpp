@@ -0,0 +1,16 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+inline int tests_passed;
+inline int tests_failed;
+
+inline void check(bool ok, const std::string& name) {
+    if (ok) {
+        tests_passed++;
+    } else {
+        std::cerr << "Error in " << name << std::endl;
+        tests_failed++;
+    }
+}
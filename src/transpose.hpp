@@ -0,0 +1,231 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+// The AVX kernel is built with a target attribute and chosen at runtime, so it is
+// used without -mavx whenever the CPU supports it.
+#define TRANSPOSE_AVX_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+using std::vector;
+
+class Transpose {
+public:
+    // Copies a strided view of `src` into `dst` in row-major order. `shape` is the
+    // shape of the view and `src_strides` the element stride of each of its axes.
+    static void permute(const float* src, const vector<int>& shape, const vector<int>& src_strides, float* dst) {
+        vector<int> dims;
+        vector<int> strides;
+        coalesce(shape, src_strides, dims, strides);
+
+        int total = 1;
+        for (int dim_size : shape) {
+            total *= dim_size;
+        }
+        if (total == 0) {
+            return;
+        }
+        if (dims.empty()) {
+            dst[0] = src[0];
+            return;
+        }
+
+        int n = dims.size();
+        vector<int> dst_strides(n, 1);
+        for (int i = n - 2; i >= 0; --i) {
+            dst_strides[i] = dst_strides[i + 1] * dims[i + 1];
+        }
+
+        // Innermost axis is contiguous in both tensors: plain row copies.
+        if (strides[n - 1] == 1) {
+            forEachOuter(dims, strides, dst_strides, n - 1, -1, [&](int src_offset, int dst_offset) {
+                std::memcpy(dst + dst_offset, src + src_offset, dims[n - 1] * sizeof(float));
+            });
+            return;
+        }
+
+        // Otherwise the source's contiguous axis sits further out in the destination,
+        // so every (that axis, innermost axis) plane is a 2D transpose.
+        int inner = 0;
+        for (int i = 0; i < n; ++i) {
+            if (strides[i] == 1) {
+                inner = i;
+            }
+        }
+        forEachOuter(dims, strides, dst_strides, n - 1, inner, [&](int src_offset, int dst_offset) {
+            tiled(src + src_offset, strides[n - 1], dst + dst_offset, dst_strides[inner], dims[inner], dims[n - 1]);
+        });
+    }
+
+    // dst[i * dst_ld + j] = src[j * src_ld + i] for i < rows, j < cols. Works through
+    // kBlock x kBlock tiles so both sides stay in cache, with an 8x8 kernel inside.
+    static void tiled(const float* src, int src_ld, float* dst, int dst_ld, int rows, int cols) {
+#if defined(TRANSPOSE_AVX_DISPATCH)
+        if (hasAvx()) {
+            tiledWith<block8x8Avx>(src, src_ld, dst, dst_ld, rows, cols);
+            return;
+        }
+#endif
+        tiledWith<block8x8Sse>(src, src_ld, dst, dst_ld, rows, cols);
+    }
+
+#if defined(TRANSPOSE_AVX_DISPATCH)
+    static bool hasAvx() {
+        static const bool has_avx = __builtin_cpu_supports("avx");
+        return has_avx;
+    }
+
+    // Transposes one 8x8 tile: dst row i takes column i of the 8 source rows.
+    __attribute__((target("avx")))
+    static void block8x8Avx(const float* src, int src_ld, float* dst, int dst_ld) {
+        __m256 r0 = _mm256_loadu_ps(src + 0 * src_ld);
+        __m256 r1 = _mm256_loadu_ps(src + 1 * src_ld);
+        __m256 r2 = _mm256_loadu_ps(src + 2 * src_ld);
+        __m256 r3 = _mm256_loadu_ps(src + 3 * src_ld);
+        __m256 r4 = _mm256_loadu_ps(src + 4 * src_ld);
+        __m256 r5 = _mm256_loadu_ps(src + 5 * src_ld);
+        __m256 r6 = _mm256_loadu_ps(src + 6 * src_ld);
+        __m256 r7 = _mm256_loadu_ps(src + 7 * src_ld);
+
+        __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+        __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+        __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+        __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+        __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+        __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+        __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+        __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+        __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+        __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+        _mm256_storeu_ps(dst + 0 * dst_ld, _mm256_permute2f128_ps(s0, s4, 0x20));
+        _mm256_storeu_ps(dst + 1 * dst_ld, _mm256_permute2f128_ps(s1, s5, 0x20));
+        _mm256_storeu_ps(dst + 2 * dst_ld, _mm256_permute2f128_ps(s2, s6, 0x20));
+        _mm256_storeu_ps(dst + 3 * dst_ld, _mm256_permute2f128_ps(s3, s7, 0x20));
+        _mm256_storeu_ps(dst + 4 * dst_ld, _mm256_permute2f128_ps(s0, s4, 0x31));
+        _mm256_storeu_ps(dst + 5 * dst_ld, _mm256_permute2f128_ps(s1, s5, 0x31));
+        _mm256_storeu_ps(dst + 6 * dst_ld, _mm256_permute2f128_ps(s2, s6, 0x31));
+        _mm256_storeu_ps(dst + 7 * dst_ld, _mm256_permute2f128_ps(s3, s7, 0x31));
+    }
+#endif
+
+    // Four 4x4 register transposes where SSE is available, plain loops otherwise.
+    static void block8x8Sse(const float* src, int src_ld, float* dst, int dst_ld) {
+#if defined(__SSE2__)
+        for (int bi = 0; bi < 8; bi += 4) {
+            for (int bj = 0; bj < 8; bj += 4) {
+                __m128 r0 = _mm_loadu_ps(src + (bj + 0) * src_ld + bi);
+                __m128 r1 = _mm_loadu_ps(src + (bj + 1) * src_ld + bi);
+                __m128 r2 = _mm_loadu_ps(src + (bj + 2) * src_ld + bi);
+                __m128 r3 = _mm_loadu_ps(src + (bj + 3) * src_ld + bi);
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                _mm_storeu_ps(dst + (bi + 0) * dst_ld + bj, r0);
+                _mm_storeu_ps(dst + (bi + 1) * dst_ld + bj, r1);
+                _mm_storeu_ps(dst + (bi + 2) * dst_ld + bj, r2);
+                _mm_storeu_ps(dst + (bi + 3) * dst_ld + bj, r3);
+            }
+        }
+#else
+        for (int i = 0; i < 8; ++i) {
+            for (int j = 0; j < 8; ++j) {
+                dst[i * dst_ld + j] = src[j * src_ld + i];
+            }
+        }
+#endif
+    }
+
+private:
+    static constexpr int kBlock = 64;
+
+    template <void (*Kernel)(const float*, int, float*, int)>
+    static void tiledWith(const float* src, int src_ld, float* dst, int dst_ld, int rows, int cols) {
+        for (int ib = 0; ib < rows; ib += kBlock) {
+            int i_end = std::min(ib + kBlock, rows);
+            for (int jb = 0; jb < cols; jb += kBlock) {
+                int j_end = std::min(jb + kBlock, cols);
+
+                int i = ib;
+                for (; i + 8 <= i_end; i += 8) {
+                    int j = jb;
+                    for (; j + 8 <= j_end; j += 8) {
+                        Kernel(src + j * src_ld + i, src_ld, dst + i * dst_ld + j, dst_ld);
+                    }
+                    scalar(src, src_ld, dst, dst_ld, i, i + 8, j, j_end);
+                }
+                scalar(src, src_ld, dst, dst_ld, i, i_end, jb, j_end);
+            }
+        }
+    }
+
+    static void scalar(const float* src, int src_ld, float* dst, int dst_ld, int i_begin, int i_end, int j_begin, int j_end) {
+        for (int i = i_begin; i < i_end; ++i) {
+            for (int j = j_begin; j < j_end; ++j) {
+                dst[i * dst_ld + j] = src[j * src_ld + i];
+            }
+        }
+    }
+
+    // Drops size-1 axes and merges neighbours that are already adjacent in the
+    // source, so e.g. [B, C, T] -> [B, T, C] becomes a batch of 2D transposes.
+    static void coalesce(const vector<int>& shape, const vector<int>& strides, vector<int>& out_shape, vector<int>& out_strides) {
+        for (size_t i = 0; i < shape.size(); ++i) {
+            if (shape[i] == 1) {
+                continue;
+            }
+            if (!out_shape.empty() && out_strides.back() == strides[i] * shape[i]) {
+                out_shape.back() *= shape[i];
+                out_strides.back() = strides[i];
+            } else {
+                out_shape.push_back(shape[i]);
+                out_strides.push_back(strides[i]);
+            }
+        }
+    }
+
+    // Calls `fn(src_offset, dst_offset)` for every index of the axes other than
+    // `skip_a` and `skip_b`.
+    template <typename Fn>
+    static void forEachOuter(const vector<int>& dims, const vector<int>& src_strides, const vector<int>& dst_strides, int skip_a, int skip_b, Fn fn) {
+        vector<int> axes;
+        for (int i = 0; i < (int)dims.size(); ++i) {
+            if (i != skip_a && i != skip_b) {
+                axes.push_back(i);
+            }
+        }
+
+        vector<int> counter(axes.size(), 0);
+        int src_offset = 0;
+        int dst_offset = 0;
+        while (true) {
+            fn(src_offset, dst_offset);
+
+            int k = axes.size() - 1;
+            for (; k >= 0; --k) {
+                int axis = axes[k];
+                counter[k]++;
+                src_offset += src_strides[axis];
+                dst_offset += dst_strides[axis];
+                if (counter[k] < dims[axis]) {
+                    break;
+                }
+                src_offset -= src_strides[axis] * dims[axis];
+                dst_offset -= dst_strides[axis] * dims[axis];
+                counter[k] = 0;
+            }
+            if (k < 0) {
+                return;
+            }
+        }
+    }
+};
@@ -9,6 +9,11 @@
 class Utils {
     public:
         static void printTensor(const Tensor &tensor, std::string name) {
+            if (tensor.getLayout() != Layout::RowMajor) {
+                printTensor(tensor.contiguous(), name);
+                return;
+            }
+
             vector<int> shape = tensor.getShape();
             if (shape.empty()) {
                 return;